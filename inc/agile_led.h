@@ -29,6 +29,19 @@ extern "C" {
 #define AGILE_LED_TYPE_DYNAMIC 0x00 /**< 动态类型 */
 #define AGILE_LED_TYPE_STATIC  0x01 /**< 静态类型 */
 
+#define AGILE_LED_LIGHT_MAX    (((RT_TICK_MAX / 2) / RT_TICK_PER_SECOND) * 1000UL) /**< 闪烁数组元素最大值 (ms)，转换为 tick 不超过 RT_TICK_MAX / 2 */
+#define AGILE_LED_SLACK_DEFAULT RT_TICK_MAX  /**< 使用默认超时宽限时间 */
+
+#define AGILE_LED_BATCH_STOP   0x01 /**< 批量操作: 停止 */
+#define AGILE_LED_BATCH_CHANGE 0x02 /**< 批量操作: 更改模式 */
+#define AGILE_LED_BATCH_START  0x04 /**< 批量操作: 启动 */
+
+#define AGILE_LED_TRACE_START    0x01 /**< 跟踪事件: 启动 */
+#define AGILE_LED_TRACE_STOP     0x02 /**< 跟踪事件: 停止 */
+#define AGILE_LED_TRACE_COMPLETE 0x03 /**< 跟踪事件: 执行完成 */
+#define AGILE_LED_TRACE_ON       0x04 /**< 跟踪事件: 亮 */
+#define AGILE_LED_TRACE_OFF      0x05 /**< 跟踪事件: 灭 */
+
 typedef struct agile_led agile_led_t; /**< Agile Led 结构体 */
 
 /**
@@ -45,9 +58,64 @@ struct agile_led {
     int32_t loop_init;                   /**< 循环次数 */
     int32_t loop_cnt;                    /**< 循环次数计数 */
     rt_tick_t tick_timeout;              /**< 超时时间 */
+    rt_tick_t tick_start;                /**< 本轮闪烁起始时间 */
+    rt_tick_t *tick_table;               /**< 闪烁时间前缀和表 (tick) */
+    uint32_t table_size;                 /**< 前缀和表元素数目 */
+    uint8_t table_const;                 /**< 前缀和表为常量 (不重建) */
+    rt_tick_t tick_slack;                /**< 超时宽限时间 */
+#ifdef PKG_AGILE_LED_USING_ENERGY
+    uint8_t lit;                         /**< 亮灭状态 */
+    uint32_t current;                    /**< 亮时电流 (uA) */
+    rt_tick_t tick_lit;                  /**< 最近一次亮的时间 */
+    rt_tick_t tick_account;              /**< 统计起始时间 */
+    uint64_t on_tick;                    /**< 累计亮时间 (tick) */
+    uint64_t charge;                     /**< 累计电荷量 (uA * tick) */
+#endif
     void (*compelete)(agile_led_t *led); /**< 操作完成回调函数 */
     rt_slist_t slist;                    /**< 单向链表节点 */
 };
+
+/**
+ * @brief   Agile Led 状态结构体
+ */
+typedef struct agile_led_state {
+    uint8_t level;         /**< 亮灭状态 (1:亮 0:灭) */
+    uint8_t finished;      /**< 执行完成标志 */
+    uint32_t arr_index;    /**< 当前数组索引 */
+    int32_t loop_remain;   /**< 剩余循环次数 (负数为永久循环) */
+    rt_tick_t tick_remain; /**< 当前状态剩余时间 */
+} agile_led_state_t;
+
+/**
+ * @brief   Agile Led 批量操作结构体
+ */
+typedef struct agile_led_batch {
+    agile_led_t *led;           /**< Agile Led 对象指针 */
+    uint8_t cmd;                /**< 操作 (AGILE_LED_BATCH_STOP/CHANGE/START 组合) */
+    const uint32_t *light_arr;  /**< 闪烁数组 (RT_NULL 为保持当前闪烁数组) */
+    uint32_t arr_num;           /**< 数组元素数目 */
+    int32_t loop_cnt;           /**< 循环次数 (负数为永久循环) */
+} agile_led_batch_t;
+
+/**
+ * @brief   Agile Led 跟踪事件结构体 (8 字节)
+ */
+typedef struct agile_led_trace_event {
+    uint32_t tick; /**< 事件时间 */
+    uint16_t pin;  /**< 引脚 */
+    uint8_t type;  /**< 事件类型 */
+    uint8_t late;  /**< 滞后时间 (tick，最大记录 255) */
+} agile_led_trace_event_t;
+
+/**
+ * @brief   Agile Led 能耗统计结构体
+ */
+typedef struct agile_led_energy {
+    uint64_t on_tick;     /**< 累计亮时间 (tick) */
+    rt_tick_t total_tick; /**< 统计时间 (tick) */
+    uint32_t duty;        /**< 占空比 (‰，全局统计为平均同时亮的对象数目 × 1000) */
+    uint64_t charge;      /**< 估算电荷量 (uAs) */
+} agile_led_energy_t;
 /**
  * @}
  */
@@ -62,16 +130,40 @@ int agile_led_dynamic_change_light_mode(agile_led_t *led, const char *light_mode
 int agile_led_set_light_mode(agile_led_t *led, const char *light_mode, int32_t loop_cnt);
 #endif
 
+int agile_led_parse_light_mode(const char *light_mode, uint32_t *light_arr, int arr_size, int *err_pos);
 int agile_led_init(agile_led_t *led, uint32_t pin, uint32_t active_logic, const uint32_t *light_array, int array_size, int32_t loop_cnt);
 int agile_led_static_change_light_mode(agile_led_t *led, const uint32_t *light_array, int array_size, int32_t loop_cnt);
+int agile_led_static_set_tick_table(agile_led_t *led, rt_tick_t *tick_table, int table_size);
+int agile_led_static_set_const_tick_table(agile_led_t *led, const rt_tick_t *tick_table, int table_size);
 int agile_led_start(agile_led_t *led);
 int agile_led_stop(agile_led_t *led);
+int agile_led_batch_control(const agile_led_batch_t *batch, int num);
 int agile_led_set_compelete_callback(agile_led_t *led, void (*compelete)(agile_led_t *led));
 void agile_led_toggle(agile_led_t *led);
 void agile_led_on(agile_led_t *led);
 void agile_led_off(agile_led_t *led);
+int agile_led_get_state(agile_led_t *led, rt_tick_t tick, agile_led_state_t *state);
+int agile_led_get_state_bitmap(rt_tick_t tick, uint32_t *bitmap, int bitmap_size);
 void agile_led_process(void);
+int agile_led_process_budget(uint32_t max_num, uint32_t max_us);
+int agile_led_set_clock_us(uint32_t (*clock_us)(void));
+int agile_led_set_late_callback(rt_tick_t threshold, void (*late)(agile_led_t *led, rt_tick_t tick_late));
+void agile_led_default_late_callback(agile_led_t *led, rt_tick_t tick_late);
+int agile_led_set_slack(agile_led_t *led, rt_tick_t slack);
+int agile_led_set_default_slack(rt_tick_t slack);
+rt_int32_t agile_led_get_wakeup_timeout(void);
 void agile_led_env_init(void);
+#ifdef PKG_AGILE_LED_USING_ENERGY
+int agile_led_set_current(agile_led_t *led, uint32_t current);
+int agile_led_get_energy(agile_led_t *led, agile_led_energy_t *energy);
+int agile_led_get_total_energy(agile_led_energy_t *energy);
+int agile_led_reset_energy(agile_led_t *led);
+int agile_led_set_duty_cap(uint32_t duty_cap);
+#endif
+#ifdef PKG_AGILE_LED_USING_TRACE
+int agile_led_trace_read(uint32_t *seq, agile_led_trace_event_t *buf, int size);
+void agile_led_trace_clear(void);
+#endif
 /**
  * @}
  */
@@ -0,0 +1,288 @@
+/**
+ * @file    agile_led.hpp
+ * @brief   Agile Led 软件包 C++ 头文件
+ * @author  马龙伟 (2544047213@qq.com)
+ * @version 1.2.0
+ * @date    2026-10-19
+ *
+ @verbatim
+    使用 (C++11 及以上):
+
+    using blink = agile::pattern<100, 200>;   // 编译期校验，存放于 flash
+    static agile::led<18, PIN_LOW> led0(blink(), -1);
+
+    led0.start();
+    led0.change<agile::pattern<50, 50, 50, 500>>(3);
+    led0.on();                                     // 编译期确定电平，无运行时判断
+
+ @endverbatim
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2021 Ma Longwei.
+ * All rights reserved.</center></h2>
+ *
+ */
+
+#ifndef __PKG_AGILE_LED_HPP
+#define __PKG_AGILE_LED_HPP
+
+#include <agile_led.h>
+
+namespace agile {
+
+/** @defgroup AGILE_LED_Cpp_Private Agile Led C++ Private
+ * @{
+ */
+namespace detail {
+
+/**
+ * @brief   编译期毫秒转换为 tick，与 rt_tick_from_millisecond 一致
+ */
+constexpr rt_tick_t tick_from_millisecond(uint32_t ms)
+{
+    return RT_TICK_PER_SECOND * (ms / 1000) + (RT_TICK_PER_SECOND * (ms % 1000) + 999) / 1000;
+}
+
+/**
+ * @brief   编译期校验所有元素不大于 AGILE_LED_LIGHT_MAX
+ */
+constexpr bool light_valid()
+{
+    return true;
+}
+
+template <typename... Rest>
+constexpr bool light_valid(uint32_t ms, Rest... rest)
+{
+    return (ms <= AGILE_LED_LIGHT_MAX) && light_valid(rest...);
+}
+
+/**
+ * @brief   编译期求和 (tick)，64 位累加用于校验周期溢出
+ */
+constexpr uint64_t tick_sum()
+{
+    return 0;
+}
+
+template <typename... Rest>
+constexpr uint64_t tick_sum(uint32_t ms, Rest... rest)
+{
+    return tick_from_millisecond(ms) + tick_sum(rest...);
+}
+
+/**
+ * @brief   编译期前缀和表，存放于 flash
+ */
+template <rt_tick_t... Sums>
+struct tick_list {
+    static constexpr rt_tick_t value[sizeof...(Sums)] = {Sums...};
+};
+
+template <rt_tick_t... Sums>
+constexpr rt_tick_t tick_list<Sums...>::value[sizeof...(Sums)];
+
+/**
+ * @brief   逐个元素累加生成前缀和表，type 为 tick_list
+ */
+template <typename List, rt_tick_t Sum, uint32_t... Ms>
+struct tick_prefix {
+    typedef List type;
+};
+
+template <rt_tick_t... Sums, rt_tick_t Sum, uint32_t M, uint32_t... Ms>
+struct tick_prefix<tick_list<Sums...>, Sum, M, Ms...>
+    : tick_prefix<tick_list<Sums..., Sum + tick_from_millisecond(M)>, Sum + tick_from_millisecond(M), Ms...> {
+};
+
+} // namespace detail
+/**
+ * @}
+ */
+
+/** @defgroup AGILE_LED_Cpp_Exported_Types Agile Led C++ Exported Types
+ * @{
+ */
+
+/**
+ * @brief   编译期闪烁模式
+ * @note    元素为亮灭时间 (ms)，按照亮灭亮灭规律。编译期校验数目、数值范围和周期，
+ *          闪烁数组和前缀和表为常量，存放于 flash。
+ */
+template <uint32_t... Ms>
+struct pattern {
+    static_assert(sizeof...(Ms) > 0, "agile_led pattern must not be empty");
+    static_assert(detail::light_valid(Ms...), "agile_led pattern element exceeds AGILE_LED_LIGHT_MAX");
+    static_assert(detail::tick_sum(Ms...) > 0, "agile_led pattern period must not be zero");
+    static_assert(detail::tick_sum(Ms...) <= RT_TICK_MAX / 2, "agile_led pattern period exceeds RT_TICK_MAX / 2");
+
+    /** 数组元素数目 */
+    static constexpr int size = sizeof...(Ms);
+    /** 闪烁数组 (ms)，传给 C 引擎 */
+    static constexpr uint32_t light_arr[sizeof...(Ms)] = {Ms...};
+    /** 闪烁时间前缀和表 (tick)，挂接到对象后 get_state 为二分查找 */
+    static constexpr const rt_tick_t *tick_table = detail::tick_prefix<detail::tick_list<>, 0, Ms...>::type::value;
+    /** 周期 (tick) */
+    static constexpr rt_tick_t period = detail::tick_sum(Ms...);
+};
+
+template <uint32_t... Ms>
+constexpr int pattern<Ms...>::size;
+
+template <uint32_t... Ms>
+constexpr uint32_t pattern<Ms...>::light_arr[sizeof...(Ms)];
+
+template <uint32_t... Ms>
+constexpr const rt_tick_t *pattern<Ms...>::tick_table;
+
+template <uint32_t... Ms>
+constexpr rt_tick_t pattern<Ms...>::period;
+
+/**
+ * @brief   Agile Led 对象
+ * @note    引脚和有效电平为模板参数，on / off 编译期确定电平。
+ *          底层使用静态 Agile Led 对象，设置模式时挂接编译期前缀和表，析构时停止运行。不可复制。
+ * @tparam  Pin 控制引脚
+ * @tparam  ActiveLogic 有效电平 (PIN_HIGH/PIN_LOW)
+ */
+template <uint32_t Pin, uint32_t ActiveLogic>
+class led {
+    static_assert((ActiveLogic == PIN_HIGH) || (ActiveLogic == PIN_LOW), "agile_led active logic must be PIN_HIGH or PIN_LOW");
+
+public:
+    /** 亮电平 */
+    static constexpr uint32_t level_on = ActiveLogic;
+    /** 灭电平 */
+    static constexpr uint32_t level_off = (ActiveLogic == PIN_HIGH) ? PIN_LOW : PIN_HIGH;
+
+    /**
+     * @brief   构造对象，不设置闪烁模式
+     */
+    led()
+    {
+        agile_led_env_init();
+        agile_led_init(&_led, Pin, ActiveLogic, RT_NULL, 0, -1);
+    }
+
+    /**
+     * @brief   构造对象并设置闪烁模式
+     * @param   loop_cnt 循环次数 (负数为永久循环)
+     */
+    template <uint32_t... Ms>
+    explicit led(pattern<Ms...>, int32_t loop_cnt = -1)
+    {
+        agile_led_env_init();
+        agile_led_init(&_led, Pin, ActiveLogic, pattern<Ms...>::light_arr, pattern<Ms...>::size, loop_cnt);
+        agile_led_static_set_const_tick_table(&_led, pattern<Ms...>::tick_table, pattern<Ms...>::size);
+    }
+
+    ~led()
+    {
+        agile_led_stop(&_led);
+    }
+
+    led(const led &) = delete;
+    led &operator=(const led &) = delete;
+
+    /**
+     * @brief   更改闪烁模式
+     * @tparam  Pattern 闪烁模式 (agile::pattern)
+     * @param   loop_cnt 循环次数 (负数为永久循环)
+     */
+    template <typename Pattern>
+    int change(int32_t loop_cnt = -1)
+    {
+        int result = agile_led_static_change_light_mode(&_led, Pattern::light_arr, Pattern::size, loop_cnt);
+        if (result == RT_EOK)
+            agile_led_static_set_const_tick_table(&_led, Pattern::tick_table, Pattern::size);
+        return result;
+    }
+
+    template <uint32_t... Ms>
+    int change(pattern<Ms...>, int32_t loop_cnt = -1)
+    {
+        return change<pattern<Ms...>>(loop_cnt);
+    }
+
+    int start()
+    {
+        return agile_led_start(&_led);
+    }
+
+    int stop()
+    {
+        return agile_led_stop(&_led);
+    }
+
+    int set_compelete_callback(void (*compelete)(agile_led_t *led))
+    {
+        return agile_led_set_compelete_callback(&_led, compelete);
+    }
+
+    int set_slack(rt_tick_t slack)
+    {
+        return agile_led_set_slack(&_led, slack);
+    }
+
+    int get_state(rt_tick_t tick, agile_led_state_t *state)
+    {
+        return agile_led_get_state(&_led, tick, state);
+    }
+
+    /**
+     * @brief   亮灭操作
+     * @note    使能 PKG_AGILE_LED_USING_ENERGY 时经过 C API 以统计亮时间
+     */
+    void on()
+    {
+#ifdef PKG_AGILE_LED_USING_ENERGY
+        agile_led_on(&_led);
+#else
+        rt_pin_write(Pin, level_on);
+#endif
+    }
+
+    void off()
+    {
+#ifdef PKG_AGILE_LED_USING_ENERGY
+        agile_led_off(&_led);
+#else
+        rt_pin_write(Pin, level_off);
+#endif
+    }
+
+    void toggle()
+    {
+#ifdef PKG_AGILE_LED_USING_ENERGY
+        agile_led_toggle(&_led);
+#else
+        rt_pin_write(Pin, (rt_pin_read(Pin) == level_on) ? level_off : level_on);
+#endif
+    }
+
+    /**
+     * @brief   获取底层 Agile Led 对象，用于 C API (如 agile_led_batch_control)
+     */
+    agile_led_t *get()
+    {
+        return &_led;
+    }
+
+private:
+    agile_led_t _led;
+};
+
+template <uint32_t Pin, uint32_t ActiveLogic>
+constexpr uint32_t led<Pin, ActiveLogic>::level_on;
+
+template <uint32_t Pin, uint32_t ActiveLogic>
+constexpr uint32_t led<Pin, ActiveLogic>::level_off;
+
+/**
+ * @}
+ */
+
+} // namespace agile
+
+#endif /* __PKG_AGILE_LED_HPP */
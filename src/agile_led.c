@@ -29,8 +29,9 @@
  */
 
 #include <agile_led.h>
-#include <stdlib.h>
-#include <string.h>
+#if (defined(PKG_AGILE_LED_USING_TRACE) || defined(PKG_AGILE_LED_USING_ENERGY)) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#endif
 
 /** @defgroup RT_Thread_DBG_Configuration RT-Thread DBG Configuration
  * @{
@@ -90,6 +91,40 @@
 
 #endif /* PKG_AGILE_LED_USING_THREAD_AUTO_INIT */
 
+/** @defgroup AGILE_LED_Configuration Agile Led Configuration
+ * @{
+ */
+
+/** @name Agile Led 配置
+ * @{
+ */
+#ifndef PKG_AGILE_LED_DEFAULT_SLACK_MS
+#define PKG_AGILE_LED_DEFAULT_SLACK_MS 5 /**< 默认超时宽限时间 (ms) */
+#endif
+
+#ifndef PKG_AGILE_LED_ENERGY_WINDOW_MS
+#define PKG_AGILE_LED_ENERGY_WINDOW_MS 1000 /**< 占空比限制统计窗口 (ms) */
+#endif
+
+#ifndef PKG_AGILE_LED_ENERGY_STRETCH_MAX
+#define PKG_AGILE_LED_ENERGY_STRETCH_MAX 8000 /**< 灭时间最大拉伸倍数 (‰) */
+#endif
+
+#ifndef PKG_AGILE_LED_TRACE_SIZE
+#define PKG_AGILE_LED_TRACE_SIZE 64 /**< 事件跟踪缓冲区事件数目 (必须是 2 的幂) */
+#endif
+
+#if (PKG_AGILE_LED_TRACE_SIZE & (PKG_AGILE_LED_TRACE_SIZE - 1))
+#error "PKG_AGILE_LED_TRACE_SIZE must be a power of 2"
+#endif
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
 /** @defgroup AGILE_LED_Private_Variables Agile Led Private Variables
  * @{
  */
@@ -97,10 +132,31 @@ ALIGN(RT_ALIGN_SIZE)
 static rt_slist_t _slist_head = RT_SLIST_OBJECT_INIT(_slist_head); /**< Agile Led 链表头节点 */
 static struct rt_mutex _mtx;                                       /**< Agile Led 互斥锁 */
 static uint8_t _is_init = 0;                                       /**< Agile Led 初始化完成标志 */
+static rt_slist_t *_cursor = RT_NULL;                              /**< 分批处理恢复位置 */
+static uint32_t (*_clock_us)(void) = RT_NULL;                      /**< 微秒时钟 */
+static rt_tick_t _late_threshold = 0;                              /**< 滞后上报阈值 */
+static void (*_late)(agile_led_t *led, rt_tick_t tick_late) = RT_NULL; /**< 滞后上报回调函数 */
+static rt_tick_t _slack = 0;                                       /**< 默认超时宽限时间 */
+
+#ifdef PKG_AGILE_LED_USING_ENERGY
+static uint64_t _on_tick = 0;        /**< 全局累计亮时间 (tick) */
+static uint64_t _charge = 0;         /**< 全局累计电荷量 (uA * tick) */
+static rt_tick_t _tick_account = 0;  /**< 全局统计起始时间 */
+static uint32_t _duty_cap = 0;       /**< 全局占空比上限 (‰，0 为不限制) */
+static uint32_t _stretch = 1000;     /**< 灭时间拉伸倍数 (‰) */
+static uint64_t _window_on_tick = 0; /**< 窗口起始时全局累计亮时间 */
+static rt_tick_t _tick_window = 0;   /**< 窗口起始时间 */
+#endif
+
+#ifdef PKG_AGILE_LED_USING_TRACE
+static agile_led_trace_event_t _trace_buf[PKG_AGILE_LED_TRACE_SIZE]; /**< 事件跟踪环形缓冲区 */
+static volatile uint32_t _trace_head = 0;                            /**< 事件跟踪写入序号 */
+#endif
 
 #ifdef PKG_AGILE_LED_USING_THREAD_AUTO_INIT
 static struct rt_thread _thread;                               /**< Agile Led 线程控制块 */
 static uint8_t _thread_stack[PKG_AGILE_LED_THREAD_STACK_SIZE]; /**< Agile Led 线程堆栈 */
+static struct rt_event _event;                                 /**< Agile Led 线程唤醒事件 */
 #endif
 /**
  * @}
@@ -120,6 +176,333 @@ static void agile_led_default_compelete_callback(agile_led_t *led)
     LOG_D("led pin:%d compeleted.", led->pin);
 }
 
+#ifdef PKG_AGILE_LED_USING_TRACE
+
+/**
+ * @brief   编译器屏障，保证事件内容与写入序号的读写顺序
+ */
+#if defined(__CC_ARM)
+#define AGILE_LED_TRACE_BARRIER() __memory_changed()
+#elif defined(__GNUC__) || defined(__clang__) || defined(__ICCARM__)
+#define AGILE_LED_TRACE_BARRIER() __asm volatile("" ::: "memory")
+#else
+#define AGILE_LED_TRACE_BARRIER() do {} while (0)
+#endif
+
+/**
+ * @brief   记录 Agile Led 跟踪事件
+ * @note    调用前必须已获取互斥锁，只有一个写入者，读取无需加锁
+ * @param   led Agile Led 对象指针
+ * @param   type 事件类型
+ * @param   tick_late 滞后时间
+ */
+static void agile_led_trace_record(agile_led_t *led, uint8_t type, rt_tick_t tick_late)
+{
+    agile_led_trace_event_t *event = &_trace_buf[_trace_head & (PKG_AGILE_LED_TRACE_SIZE - 1)];
+
+    event->tick = rt_tick_get();
+    event->pin = led->pin;
+    event->type = type;
+    event->late = (tick_late > 0xFF) ? 0xFF : tick_late;
+    AGILE_LED_TRACE_BARRIER();
+    _trace_head++;
+}
+
+#define AGILE_LED_TRACE(led, type, tick_late) agile_led_trace_record(led, type, tick_late)
+#else
+#define AGILE_LED_TRACE(led, type, tick_late) do {} while (0)
+#endif /* PKG_AGILE_LED_USING_TRACE */
+
+#ifdef PKG_AGILE_LED_USING_ENERGY
+
+/**
+ * @brief   Agile Led 对象亮灭变化时累计亮时间
+ * @param   led Agile Led 对象指针
+ * @param   lit 新的亮灭状态
+ */
+static void agile_led_account(agile_led_t *led, uint8_t lit)
+{
+    rt_tick_t tick = rt_tick_get();
+
+    rt_enter_critical();
+    if (led->lit && !lit) {
+        rt_tick_t delta = tick - led->tick_lit;
+        led->on_tick += delta;
+        led->charge += (uint64_t)delta * led->current;
+        _on_tick += delta;
+        _charge += (uint64_t)delta * led->current;
+    } else if (!led->lit && lit) {
+        led->tick_lit = tick;
+    }
+    led->lit = lit;
+    rt_exit_critical();
+}
+
+/**
+ * @brief   更新灭时间拉伸倍数
+ * @note    调用前必须已获取互斥锁。每个统计窗口按窗口内平均占空比与上限的比值调整。
+ */
+static void agile_led_duty_update(void)
+{
+    rt_tick_t tick = rt_tick_get();
+    rt_tick_t elapsed = tick - _tick_window;
+
+    if (elapsed < rt_tick_from_millisecond(PKG_AGILE_LED_ENERGY_WINDOW_MS))
+        return;
+
+    if (_duty_cap) {
+        uint32_t duty = (uint32_t)((_on_tick - _window_on_tick) * 1000 / elapsed);
+        uint64_t stretch = (uint64_t)_stretch * duty / _duty_cap;
+        if (stretch < 1000)
+            stretch = 1000;
+        if (stretch > PKG_AGILE_LED_ENERGY_STRETCH_MAX)
+            stretch = PKG_AGILE_LED_ENERGY_STRETCH_MAX;
+        _stretch = stretch;
+    } else {
+        _stretch = 1000;
+    }
+
+    _tick_window = tick;
+    _window_on_tick = _on_tick;
+}
+
+/**
+ * @brief   初始化 Agile Led 对象能耗统计
+ * @param   led Agile Led 对象指针
+ */
+static void agile_led_energy_init(agile_led_t *led)
+{
+    led->lit = 0;
+    led->current = 0;
+    led->tick_lit = rt_tick_get();
+    led->tick_account = led->tick_lit;
+    led->on_tick = 0;
+    led->charge = 0;
+}
+
+#define AGILE_LED_ACCOUNT(led, lit) agile_led_account(led, lit)
+#else
+#define AGILE_LED_ACCOUNT(led, lit) do {} while (0)
+#endif /* PKG_AGILE_LED_USING_ENERGY */
+
+/**
+ * @brief   从头开始 Agile Led 对象的闪烁模式
+ * @note    调用前必须已获取互斥锁
+ * @param   led Agile Led 对象指针
+ * @param   tick 起始时间
+ */
+static void agile_led_reset(agile_led_t *led, rt_tick_t tick)
+{
+    led->arr_index = 0;
+    led->loop_cnt = led->loop_init;
+    led->tick_timeout = tick;
+    led->tick_start = tick;
+}
+
+/**
+ * @brief   获取 Agile Led 对象超时宽限时间
+ * @param   led Agile Led 对象指针
+ * @return  宽限时间 (tick)
+ */
+static rt_tick_t agile_led_get_slack(agile_led_t *led)
+{
+    return (led->tick_slack == AGILE_LED_SLACK_DEFAULT) ? _slack : led->tick_slack;
+}
+
+/**
+ * @brief   唤醒 Agile Led 内部线程重新计算等待时间
+ * @note    未使能 PKG_AGILE_LED_USING_THREAD_AUTO_INIT 时为空操作
+ */
+static void agile_led_wakeup(void)
+{
+#ifdef PKG_AGILE_LED_USING_THREAD_AUTO_INIT
+    rt_event_send(&_event, 0x01);
+#endif
+}
+
+/**
+ * @brief   处理单个 Agile Led 对象
+ * @note    调用前必须已获取互斥锁
+ * @param   led Agile Led 对象指针
+ * @return  0:未到期; 1:已处理; 2:执行完成并已停止
+ */
+static int agile_led_handle(agile_led_t *led)
+{
+    if (led->loop_cnt == 0)
+        goto __compelete;
+
+    rt_tick_t tick_late = rt_tick_get() - led->tick_timeout;
+    if (tick_late >= (RT_TICK_MAX / 2))
+        return 0;
+    if (_late && (tick_late > agile_led_get_slack(led) + _late_threshold))
+        _late(led, tick_late);
+
+    uint8_t wrapped = 0;
+__repeat:
+    if (led->arr_index < led->arr_num) {
+        if (led->light_arr[led->arr_index] == 0) {
+            led->arr_index++;
+            goto __repeat;
+        }
+        tick_late = rt_tick_get() - led->tick_timeout;
+        if (led->arr_index % 2) {
+            agile_led_off(led);
+            AGILE_LED_TRACE(led, AGILE_LED_TRACE_OFF, tick_late);
+        } else {
+            agile_led_on(led);
+            AGILE_LED_TRACE(led, AGILE_LED_TRACE_ON, tick_late);
+        }
+        /* 以上次超时时间为基准，避免处理延迟累积，严重滞后时重新对齐 */
+        rt_tick_t tick_light = rt_tick_from_millisecond(led->light_arr[led->arr_index]);
+#ifdef PKG_AGILE_LED_USING_ENERGY
+        /* 超出全局占空比上限时拉伸灭时间，起始时间同步后移 */
+        if ((led->arr_index % 2) && (_stretch > 1000)) {
+            rt_tick_t tick_stretch = (uint64_t)tick_light * _stretch / 1000;
+            led->tick_start += tick_stretch - tick_light;
+            tick_light = tick_stretch;
+        }
+#endif
+        if (tick_late >= tick_light) {
+            led->tick_start += tick_late;
+            led->tick_timeout += tick_late;
+        }
+        led->tick_timeout += tick_light;
+        led->arr_index++;
+    } else {
+        led->arr_index = 0;
+        if (led->loop_cnt > 0)
+            led->loop_cnt--;
+        if (led->loop_cnt == 0)
+            goto __compelete;
+        /* 下一轮起始时间即当前超时时间，直接处理，避免额外唤醒 */
+        if (!wrapped) {
+            wrapped = 1;
+            goto __repeat;
+        }
+        /* 连续两次回绕未处理任何元素，周期为 0，超时时间不会推进，停止运行避免空转 */
+        LOG_W("led pin:%d period is zero, stopped.", led->pin);
+        goto __compelete;
+    }
+
+    return 1;
+
+__compelete:
+    AGILE_LED_TRACE(led, AGILE_LED_TRACE_COMPLETE, rt_tick_get() - led->tick_timeout);
+    agile_led_stop(led);
+    if (led->compelete) {
+        led->compelete(led);
+    }
+
+    return 2;
+}
+
+/**
+ * @brief   检查闪烁数组是否可运行
+ * @note    周期为 0 的模式不会推进超时时间，引擎将不停被唤醒；
+ *          周期超过 RT_TICK_MAX / 2 时超时比较和前缀和表溢出。均不允许运行。
+ * @param   light_arr 闪烁数组
+ * @param   arr_num 数组元素数目
+ * @return  1:可运行; 0:数组为空、周期为 0、元素超过 AGILE_LED_LIGHT_MAX 或周期溢出
+ */
+static int agile_led_period_valid(const uint32_t *light_arr, uint32_t arr_num)
+{
+    rt_tick_t period = 0;
+
+    if (light_arr == RT_NULL)
+        return 0;
+
+    for (uint32_t i = 0; i < arr_num; i++) {
+        if (light_arr[i] > AGILE_LED_LIGHT_MAX)
+            return 0;
+        /* 单个元素不超过 RT_TICK_MAX / 2，累加前周期也不超过，不会回绕 */
+        period += rt_tick_from_millisecond(light_arr[i]);
+        if (period > (RT_TICK_MAX / 2))
+            return 0;
+    }
+
+    return (period > 0);
+}
+
+/**
+ * @brief   重建 Agile Led 对象闪烁时间前缀和表
+ * @note    前缀和表不足以容纳闪烁数组时不处理，状态查询退化为顺序查找。
+ *          常量前缀和表只对应设置时的闪烁数组，直接取消。
+ * @param   led Agile Led 对象指针
+ */
+static void agile_led_build_tick_table(agile_led_t *led)
+{
+    RT_ASSERT(led);
+
+    if (led->table_const) {
+        led->tick_table = RT_NULL;
+        led->table_size = 0;
+        led->table_const = 0;
+        return;
+    }
+
+    if ((led->tick_table == RT_NULL) || (led->table_size < led->arr_num))
+        return;
+
+    rt_tick_t sum = 0;
+    for (uint32_t i = 0; i < led->arr_num; i++) {
+        sum += rt_tick_from_millisecond(led->light_arr[i]);
+        led->tick_table[i] = sum;
+    }
+}
+
+/**
+ * @brief   更新 Agile Led 对象闪烁数组并重建前缀和表
+ * @note    调用前必须已获取互斥锁。agile_led_get_state 不获取互斥锁，
+ *          在关闭调度器时整体更新，查询不会看到不一致的数组、数目和前缀和表。
+ * @param   led Agile Led 对象指针
+ * @param   light_arr 闪烁数组
+ * @param   arr_num 数组元素数目
+ */
+static void agile_led_set_light_arr(agile_led_t *led, const uint32_t *light_arr, uint32_t arr_num)
+{
+    rt_enter_critical();
+    led->light_arr = light_arr;
+    led->arr_num = arr_num;
+    agile_led_build_tick_table(led);
+    rt_exit_critical();
+}
+
+/**
+ * @brief   查找闪烁周期内偏移时间所处的数组索引
+ * @note    有前缀和表时二分查找，否则顺序查找。跳过时间为 0 的元素。
+ * @param   led Agile Led 对象指针
+ * @param   offset 周期内偏移时间 (tick)，传入 RT_TICK_MAX 可获取周期总时间
+ * @param   tick_end 存放该元素结束时间 (相对周期起点)
+ * @return  数组索引，offset 超出周期时返回 arr_num
+ */
+static uint32_t agile_led_tick_search(agile_led_t *led, rt_tick_t offset, rt_tick_t *tick_end)
+{
+    uint32_t low = 0;
+    uint32_t high = led->arr_num;
+    rt_tick_t sum = 0;
+
+    if ((led->tick_table != RT_NULL) && (led->table_size >= led->arr_num)) {
+        while (low < high) {
+            uint32_t mid = low + (high - low) / 2;
+            if (led->tick_table[mid] > offset)
+                high = mid;
+            else
+                low = mid + 1;
+        }
+        *tick_end = led->tick_table[(low < led->arr_num) ? low : (led->arr_num - 1)];
+        return low;
+    }
+
+    for (low = 0; low < high; low++) {
+        sum += rt_tick_from_millisecond(led->light_arr[low]);
+        if (sum > offset)
+            break;
+    }
+    *tick_end = sum;
+
+    return low;
+}
+
 #ifdef RT_USING_HEAP
 
 /**
@@ -129,7 +512,7 @@ static void agile_led_default_compelete_callback(agile_led_t *led)
  @verbatim
     例子:
     "100,200,100,200"
-    只支持正整数，按照亮灭亮灭规律
+    只支持非负整数，按照亮灭亮灭规律
 
  @endverbatim
  * @return  RT_EOK:成功; !=RT_EOK:异常
@@ -139,34 +522,36 @@ static int agile_led_get_light_arr(agile_led_t *led, const char *light_mode)
     RT_ASSERT(led);
     RT_ASSERT(led->type == AGILE_LED_TYPE_DYNAMIC);
     RT_ASSERT(led->light_arr == RT_NULL);
+    RT_ASSERT(led->tick_table == RT_NULL);
     RT_ASSERT(led->arr_num == 0);
 
-    const char *ptr = light_mode;
-    while (*ptr) {
-        if (*ptr == ',')
-            led->arr_num++;
-        ptr++;
+    int err_pos = 0;
+    int arr_num = agile_led_parse_light_mode(light_mode, RT_NULL, 0, &err_pos);
+    if (arr_num < 0) {
+        LOG_E("light mode \"%s\" invalid at %d.", light_mode, err_pos);
+        return arr_num;
     }
-    if (*(ptr - 1) != ',')
-        led->arr_num++;
-
-    if (led->arr_num == 0)
-        return -RT_ERROR;
 
-    uint32_t *light_arr = rt_malloc(led->arr_num * sizeof(uint32_t));
-    if (light_arr == RT_NULL)
+    /* 前缀和表与闪烁数组一次申请，前缀和表在前保证对齐 */
+    rt_tick_t *tick_table = rt_malloc(arr_num * (sizeof(rt_tick_t) + sizeof(uint32_t)));
+    if (tick_table == RT_NULL)
         return -RT_ENOMEM;
-    rt_memset(light_arr, 0, led->arr_num * sizeof(uint32_t));
 
-    ptr = light_mode;
-    for (uint32_t i = 0; i < led->arr_num; i++) {
-        light_arr[i] = atoi(ptr);
-        ptr = strchr(ptr, ',');
-        if (ptr)
-            ptr++;
+    uint32_t *light_arr = (uint32_t *)(tick_table + arr_num);
+    agile_led_parse_light_mode(light_mode, light_arr, arr_num, RT_NULL);
+    if (!agile_led_period_valid(light_arr, arr_num)) {
+        LOG_E("light mode \"%s\" period is zero or overflows.", light_mode);
+        rt_free(tick_table);
+        return -RT_EINVAL;
     }
 
+    rt_enter_critical();
     led->light_arr = light_arr;
+    led->arr_num = arr_num;
+    led->tick_table = tick_table;
+    led->table_size = arr_num;
+    agile_led_build_tick_table(led);
+    rt_exit_critical();
 
     return RT_EOK;
 }
@@ -181,6 +566,89 @@ static int agile_led_get_light_arr(agile_led_t *led, const char *light_mode)
  * @{
  */
 
+/**
+ * @brief   解析闪烁模式字符串
+ * @note    单次遍历完成校验和填充，不申请内存。light_arr 为 RT_NULL 时只校验并返回元素数目，
+ *          可用于确定缓冲区大小。
+ * @param   light_mode 闪烁模式字符串
+ @verbatim
+    例子:
+    "100,200,100,200"
+    只支持非负十进制整数 (不大于 AGILE_LED_LIGHT_MAX)，数字前后允许空格，
+    允许末尾一个逗号，不允许空字段
+
+ @endverbatim
+ * @param   light_arr 存放结果的缓冲区 (可以为 RT_NULL)
+ * @param   arr_size 缓冲区元素数目
+ * @param   err_pos 出错时存放错误位置 (字符偏移，可以为 RT_NULL)
+ * @return  >0:元素数目; -RT_EINVAL:格式错误、空字段或数值溢出; -RT_EFULL:缓冲区不足
+ */
+int agile_led_parse_light_mode(const char *light_mode, uint32_t *light_arr, int arr_size, int *err_pos)
+{
+    const char *ptr = light_mode;
+    const char *field = light_mode;
+    uint8_t state = 0; /* 0:等待数字 1:数字中 2:数字后的空格 */
+    uint32_t value = 0;
+    int num = 0;
+    int result = -RT_EINVAL;
+
+    if (light_mode == RT_NULL) {
+        if (err_pos)
+            *err_pos = 0;
+        return -RT_EINVAL;
+    }
+
+    while (1) {
+        char ch = *ptr;
+
+        if ((ch >= '0') && (ch <= '9')) {
+            uint32_t digit = ch - '0';
+
+            if (state == 2)
+                break;
+            if (value > (AGILE_LED_LIGHT_MAX - digit) / 10)
+                break;
+            if (state == 0)
+                field = ptr;
+            value = value * 10 + digit;
+            state = 1;
+        } else if ((ch == ' ') || (ch == '\t')) {
+            if (state == 1)
+                state = 2;
+        } else if ((ch == ',') || (ch == '\0')) {
+            if (state == 0) {
+                if ((ch == '\0') && (num > 0))
+                    result = num;
+                break;
+            }
+            if (light_arr) {
+                if (num >= arr_size) {
+                    ptr = field;
+                    result = -RT_EFULL;
+                    break;
+                }
+                light_arr[num] = value;
+            }
+            num++;
+            value = 0;
+            state = 0;
+            if (ch == '\0') {
+                result = num;
+                break;
+            }
+        } else {
+            break;
+        }
+
+        ptr++;
+    }
+
+    if ((result < 0) && err_pos)
+        *err_pos = ptr - light_mode;
+
+    return result;
+}
+
 #ifdef RT_USING_HEAP
 
 /**
@@ -215,6 +683,9 @@ agile_led_t *agile_led_create(uint32_t pin, uint32_t active_logic, const char *l
     led->light_arr = RT_NULL;
     led->arr_num = 0;
     led->arr_index = 0;
+    led->tick_table = RT_NULL;
+    led->table_size = 0;
+    led->table_const = 0;
     if (light_mode) {
         if (agile_led_get_light_arr(led, light_mode) != RT_EOK) {
             rt_free(led);
@@ -225,6 +696,11 @@ agile_led_t *agile_led_create(uint32_t pin, uint32_t active_logic, const char *l
     led->loop_init = loop_cnt;
     led->loop_cnt = led->loop_init;
     led->tick_timeout = rt_tick_get();
+    led->tick_start = led->tick_timeout;
+    led->tick_slack = AGILE_LED_SLACK_DEFAULT;
+#ifdef PKG_AGILE_LED_USING_ENERGY
+    agile_led_energy_init(led);
+#endif
     led->compelete = agile_led_default_compelete_callback;
     rt_slist_init(&(led->slist));
 
@@ -245,12 +721,15 @@ int agile_led_delete(agile_led_t *led)
     RT_ASSERT(led->type == AGILE_LED_TYPE_DYNAMIC);
 
     rt_mutex_take(&_mtx, RT_WAITING_FOREVER);
+    if (_cursor == &(led->slist))
+        _cursor = rt_slist_next(_cursor);
     rt_slist_remove(&_slist_head, &(led->slist));
     led->slist.next = RT_NULL;
     rt_mutex_release(&_mtx);
 
-    if (led->light_arr) {
-        rt_free((uint32_t *)led->light_arr);
+    if (led->tick_table) {
+        rt_free(led->tick_table);
+        led->tick_table = RT_NULL;
         led->light_arr = RT_NULL;
     }
     rt_free(led);
@@ -279,11 +758,16 @@ int agile_led_dynamic_change_light_mode(agile_led_t *led, const char *light_mode
 
     rt_mutex_take(&_mtx, RT_WAITING_FOREVER);
     if (light_mode) {
-        if (led->light_arr) {
-            rt_free((uint32_t *)led->light_arr);
-            led->light_arr = RT_NULL;
-        }
+        /* agile_led_get_state 不获取互斥锁，先在关闭调度器时摘除再释放 */
+        rt_tick_t *tick_table = led->tick_table;
+        rt_enter_critical();
+        led->tick_table = RT_NULL;
+        led->light_arr = RT_NULL;
         led->arr_num = 0;
+        led->table_size = 0;
+        rt_exit_critical();
+        if (tick_table)
+            rt_free(tick_table);
         if (agile_led_get_light_arr(led, light_mode) != RT_EOK) {
             agile_led_stop(led);
             rt_mutex_release(&_mtx);
@@ -291,11 +775,13 @@ int agile_led_dynamic_change_light_mode(agile_led_t *led, const char *light_mode
         }
     }
     led->loop_init = loop_cnt;
-    led->arr_index = 0;
-    led->loop_cnt = led->loop_init;
-    led->tick_timeout = rt_tick_get();
+    agile_led_reset(led, rt_tick_get());
+    if (led->active)
+        AGILE_LED_TRACE(led, AGILE_LED_TRACE_START, 0);
     rt_mutex_release(&_mtx);
 
+    agile_led_wakeup();
+
     return RT_EOK;
 }
 
@@ -352,9 +838,17 @@ int agile_led_init(agile_led_t *led, uint32_t pin, uint32_t active_logic, const
     led->light_arr = light_array;
     led->arr_num = array_size;
     led->arr_index = 0;
+    led->tick_table = RT_NULL;
+    led->table_size = 0;
+    led->table_const = 0;
     led->loop_init = loop_cnt;
     led->loop_cnt = led->loop_init;
     led->tick_timeout = rt_tick_get();
+    led->tick_start = led->tick_timeout;
+    led->tick_slack = AGILE_LED_SLACK_DEFAULT;
+#ifdef PKG_AGILE_LED_USING_ENERGY
+    agile_led_energy_init(led);
+#endif
     led->compelete = agile_led_default_compelete_callback;
     rt_slist_init(&(led->slist));
 
@@ -377,7 +871,7 @@ int agile_led_init(agile_led_t *led, uint32_t pin, uint32_t active_logic, const
  @endverbatim
  * @param   array_size 闪烁数组数目
  * @param   loop_cnt 循环次数 (负数为永久循环)
- * @return  RT_EOK:成功
+ * @return  RT_EOK:成功; -RT_EINVAL:闪烁数组周期为 0 或溢出，或对象运行中时闪烁数组为空
  */
 int agile_led_static_change_light_mode(agile_led_t *led, const uint32_t *light_array, int array_size, int32_t loop_cnt)
 {
@@ -385,12 +879,70 @@ int agile_led_static_change_light_mode(agile_led_t *led, const uint32_t *light_a
     RT_ASSERT(led->type == AGILE_LED_TYPE_STATIC);
 
     rt_mutex_take(&_mtx, RT_WAITING_FOREVER);
-    led->light_arr = light_array;
-    led->arr_num = array_size;
-    led->arr_index = 0;
+    /* 停止状态允许清空闪烁数组，运行中必须是可运行的模式 */
+    if (((array_size > 0) || led->active) && !agile_led_period_valid(light_array, array_size)) {
+        rt_mutex_release(&_mtx);
+        return -RT_EINVAL;
+    }
+    agile_led_set_light_arr(led, light_array, array_size);
     led->loop_init = loop_cnt;
-    led->loop_cnt = led->loop_init;
-    led->tick_timeout = rt_tick_get();
+    agile_led_reset(led, rt_tick_get());
+    if (led->active)
+        AGILE_LED_TRACE(led, AGILE_LED_TRACE_START, 0);
+    rt_mutex_release(&_mtx);
+
+    agile_led_wakeup();
+
+    return RT_EOK;
+}
+
+/**
+ * @brief   设置静态 Agile Led 对象的闪烁时间前缀和表
+ * @note    Agile Led 对象必须是静态的。前缀和表用于 agile_led_get_state 二分查找，
+ *          不设置时状态查询为顺序查找。更改模式时会自动重建。
+ * @param   led Agile Led 对象指针
+ * @param   tick_table 前缀和表缓冲区 (RT_NULL 为取消)
+ * @param   table_size 前缀和表元素数目，不小于闪烁数组数目时生效
+ * @return  RT_EOK:成功
+ */
+int agile_led_static_set_tick_table(agile_led_t *led, rt_tick_t *tick_table, int table_size)
+{
+    RT_ASSERT(led);
+    RT_ASSERT(led->type == AGILE_LED_TYPE_STATIC);
+
+    rt_mutex_take(&_mtx, RT_WAITING_FOREVER);
+    rt_enter_critical();
+    led->tick_table = tick_table;
+    led->table_size = tick_table ? table_size : 0;
+    led->table_const = 0;
+    agile_led_build_tick_table(led);
+    rt_exit_critical();
+    rt_mutex_release(&_mtx);
+
+    return RT_EOK;
+}
+
+/**
+ * @brief   设置静态 Agile Led 对象的常量闪烁时间前缀和表
+ * @note    Agile Led 对象必须是静态的。前缀和表必须与当前闪烁数组对应 (如 agile_led.hpp 编译期生成)，
+ *          不重建，可存放于 flash。更改模式时自动取消。
+ * @param   led Agile Led 对象指针
+ * @param   tick_table 前缀和表 (RT_NULL 为取消)
+ * @param   table_size 前缀和表元素数目，不小于闪烁数组数目时生效
+ * @return  RT_EOK:成功
+ */
+int agile_led_static_set_const_tick_table(agile_led_t *led, const rt_tick_t *tick_table, int table_size)
+{
+    RT_ASSERT(led);
+    RT_ASSERT(led->type == AGILE_LED_TYPE_STATIC);
+
+    rt_mutex_take(&_mtx, RT_WAITING_FOREVER);
+    rt_enter_critical();
+    /* table_const 置位后不会写入 */
+    led->tick_table = (rt_tick_t *)tick_table;
+    led->table_size = tick_table ? table_size : 0;
+    led->table_const = (tick_table != RT_NULL);
+    rt_exit_critical();
     rt_mutex_release(&_mtx);
 
     return RT_EOK;
@@ -410,17 +962,18 @@ int agile_led_start(agile_led_t *led)
         rt_mutex_release(&_mtx);
         return -RT_ERROR;
     }
-    if ((led->light_arr == RT_NULL) || (led->arr_num == 0)) {
+    if (!agile_led_period_valid(led->light_arr, led->arr_num)) {
         rt_mutex_release(&_mtx);
         return -RT_ERROR;
     }
-    led->arr_index = 0;
-    led->loop_cnt = led->loop_init;
-    led->tick_timeout = rt_tick_get();
+    agile_led_reset(led, rt_tick_get());
     rt_slist_append(&_slist_head, &(led->slist));
     led->active = 1;
+    AGILE_LED_TRACE(led, AGILE_LED_TRACE_START, 0);
     rt_mutex_release(&_mtx);
 
+    agile_led_wakeup();
+
     return RT_EOK;
 }
 
@@ -438,40 +991,130 @@ int agile_led_stop(agile_led_t *led)
         rt_mutex_release(&_mtx);
         return RT_EOK;
     }
+    if (_cursor == &(led->slist))
+        _cursor = rt_slist_next(_cursor);
     rt_slist_remove(&_slist_head, &(led->slist));
     led->slist.next = RT_NULL;
     led->active = 0;
+    AGILE_LED_TRACE(led, AGILE_LED_TRACE_STOP, 0);
     rt_mutex_release(&_mtx);
 
     return RT_EOK;
 }
 
 /**
- * @brief   设置 Agile Led 对象操作完成的回调函数
- * @param   led Agile Led 对象指针
- * @param   compelete 操作完成回调函数
- * @return  RT_EOK:成功
+ * @brief   批量控制 Agile Led 对象
+ * @note    所有操作在同一次获取互斥锁内完成，使用同一个起始时间，对象之间保持同相位。
+ *          每个元素按 停止 -> 更改模式 -> 启动 顺序执行。先校验全部元素，任一元素不合法则不执行任何操作。
+ *          同一个对象在数组中只能出现一次，否则返回 -RT_EINVAL。
+ * @param   batch 批量操作数组
+ @verbatim
+    AGILE_LED_BATCH_STOP:   停止
+    AGILE_LED_BATCH_CHANGE: 更改模式，light_arr 为 RT_NULL 时保持当前闪烁数组，只更新循环次数并从头开始；
+                            light_arr 不为 RT_NULL 时对象必须是静态的，操作后仍运行的对象不能更改为空数组
+    AGILE_LED_BATCH_START:  启动，未同时停止时对象必须处于停止状态
+
+ @endverbatim
+ * @param   num 批量操作数组元素数目
+ * @return  RT_EOK:成功; -RT_EINVAL:存在不合法的元素，未执行任何操作
  */
-int agile_led_set_compelete_callback(agile_led_t *led, void (*compelete)(agile_led_t *led))
+int agile_led_batch_control(const agile_led_batch_t *batch, int num)
 {
-    RT_ASSERT(led);
+    RT_ASSERT(batch);
 
     rt_mutex_take(&_mtx, RT_WAITING_FOREVER);
-    led->compelete = compelete;
+    for (int i = 0; i < num; i++) {
+        const agile_led_batch_t *item = &batch[i];
+        RT_ASSERT(item->led);
+
+        for (int j = 0; j < i; j++) {
+            if (batch[j].led == item->led)
+                goto _invalid;
+        }
+
+        const uint32_t *light_arr = item->led->light_arr;
+        uint32_t arr_num = item->led->arr_num;
+        if ((item->cmd & AGILE_LED_BATCH_CHANGE) && item->light_arr) {
+            if (item->led->type != AGILE_LED_TYPE_STATIC)
+                goto _invalid;
+            light_arr = item->light_arr;
+            arr_num = item->arr_num;
+            if ((arr_num > 0) && !agile_led_period_valid(light_arr, arr_num))
+                goto _invalid;
+        }
+
+        if ((item->cmd & AGILE_LED_BATCH_START) && item->led->active && !(item->cmd & AGILE_LED_BATCH_STOP))
+            goto _invalid;
+
+        /* 操作后仍在运行或将要启动的对象，闪烁数组必须是可运行的模式 */
+        uint8_t running = (item->cmd & AGILE_LED_BATCH_START) || (item->led->active && !(item->cmd & AGILE_LED_BATCH_STOP));
+        if (running && !agile_led_period_valid(light_arr, arr_num))
+            goto _invalid;
+    }
+
+    rt_tick_t tick = rt_tick_get();
+    for (int i = 0; i < num; i++) {
+        const agile_led_batch_t *item = &batch[i];
+        agile_led_t *led = item->led;
+
+        if (item->cmd & AGILE_LED_BATCH_STOP)
+            agile_led_stop(led);
+
+        if (item->cmd & AGILE_LED_BATCH_CHANGE) {
+            if (item->light_arr)
+                agile_led_set_light_arr(led, item->light_arr, item->arr_num);
+            led->loop_init = item->loop_cnt;
+            agile_led_reset(led, tick);
+            if (led->active)
+                AGILE_LED_TRACE(led, AGILE_LED_TRACE_START, 0);
+        }
+
+        if (item->cmd & AGILE_LED_BATCH_START) {
+            agile_led_reset(led, tick);
+            rt_slist_append(&_slist_head, &(led->slist));
+            led->active = 1;
+            AGILE_LED_TRACE(led, AGILE_LED_TRACE_START, 0);
+        }
+    }
     rt_mutex_release(&_mtx);
 
+    agile_led_wakeup();
+
     return RT_EOK;
+
+_invalid:
+    rt_mutex_release(&_mtx);
+    return -RT_EINVAL;
 }
 
 /**
- * @brief   Agile Led 对象电平翻转
+ * @brief   设置 Agile Led 对象操作完成的回调函数
+ * @param   led Agile Led 对象指针
+ * @param   compelete 操作完成回调函数
+ * @return  RT_EOK:成功
+ */
+int agile_led_set_compelete_callback(agile_led_t *led, void (*compelete)(agile_led_t *led))
+{
+    RT_ASSERT(led);
+
+    rt_mutex_take(&_mtx, RT_WAITING_FOREVER);
+    led->compelete = compelete;
+    rt_mutex_release(&_mtx);
+
+    return RT_EOK;
+}
+
+/**
+ * @brief   Agile Led 对象电平翻转
  * @param   led Agile Led 对象指针
  */
 void agile_led_toggle(agile_led_t *led)
 {
     RT_ASSERT(led);
 
-    rt_pin_write(led->pin, !rt_pin_read(led->pin));
+    int level = !rt_pin_read(led->pin);
+    rt_pin_write(led->pin, level);
+    AGILE_LED_ACCOUNT(led, (uint32_t)level == led->active_logic);
 }
 
 /**
@@ -483,6 +1126,7 @@ void agile_led_on(agile_led_t *led)
     RT_ASSERT(led);
 
     rt_pin_write(led->pin, led->active_logic);
+    AGILE_LED_ACCOUNT(led, 1);
 }
 
 /**
@@ -494,54 +1138,467 @@ void agile_led_off(agile_led_t *led)
     RT_ASSERT(led);
 
     rt_pin_write(led->pin, !led->active_logic);
+    AGILE_LED_ACCOUNT(led, 0);
+}
+
+/**
+ * @brief   计算 Agile Led 对象在指定时刻的状态
+ * @note    根据闪烁模式、循环次数和起始时间推算，不读取引脚，不获取互斥锁，
+ *          只在查找期间关闭调度器。结果为理想时间线，实际引脚变化滞后不超过宽限时间。
+ * @param   led Agile Led 对象指针
+ * @param   tick 查询时刻，不能早于对象启动时刻
+ * @param   state 存放状态
+ * @return  RT_EOK:成功; -RT_ERROR:对象未运行或周期为 0; -RT_EINVAL:查询时刻早于启动时刻
+ */
+int agile_led_get_state(agile_led_t *led, rt_tick_t tick, agile_led_state_t *state)
+{
+    RT_ASSERT(led);
+    RT_ASSERT(state);
+
+    int result = RT_EOK;
+    rt_tick_t tick_end = 0;
+
+    rt_enter_critical();
+    do {
+        if (!led->active || (led->arr_num == 0)) {
+            result = -RT_ERROR;
+            break;
+        }
+
+        rt_tick_t elapsed = tick - led->tick_start;
+        if (elapsed >= (RT_TICK_MAX / 2)) {
+            result = -RT_EINVAL;
+            break;
+        }
+
+        rt_tick_t period = 0;
+        agile_led_tick_search(led, RT_TICK_MAX, &period);
+        if (period == 0) {
+            result = -RT_ERROR;
+            break;
+        }
+
+        uint32_t cycle = elapsed / period;
+        if ((led->loop_init >= 0) && (cycle >= (uint32_t)led->loop_init)) {
+            state->finished = 1;
+            state->arr_index = led->arr_num;
+            state->loop_remain = 0;
+            state->tick_remain = 0;
+            /* 保持最后一个非 0 元素的电平 */
+            state->level = (led->loop_init > 0) ? !(agile_led_tick_search(led, period - 1, &tick_end) % 2) : 0;
+            break;
+        }
+
+        rt_tick_t offset = elapsed % period;
+        uint32_t index = agile_led_tick_search(led, offset, &tick_end);
+        state->finished = 0;
+        state->arr_index = index;
+        state->loop_remain = (led->loop_init >= 0) ? (int32_t)(led->loop_init - cycle) : -1;
+        state->tick_remain = tick_end - offset;
+        state->level = !(index % 2);
+    } while (0);
+    rt_exit_critical();
+
+    return result;
+}
+
+/**
+ * @brief   计算所有运行中 Agile Led 对象在指定时刻的亮灭状态
+ * @note    位图按引脚号索引，亮为 1。超出位图范围的引脚忽略。
+ * @param   tick 查询时刻
+ * @param   bitmap 位图缓冲区
+ * @param   bitmap_size 位图缓冲区元素数目 (每个元素 32 位)
+ * @return  参与计算的对象数目
+ */
+int agile_led_get_state_bitmap(rt_tick_t tick, uint32_t *bitmap, int bitmap_size)
+{
+    RT_ASSERT(bitmap);
+
+    rt_slist_t *node;
+    agile_led_state_t state;
+    int num = 0;
+
+    rt_memset(bitmap, 0, bitmap_size * sizeof(uint32_t));
+
+    rt_enter_critical();
+    rt_slist_for_each(node, &_slist_head)
+    {
+        agile_led_t *led = rt_slist_entry(node, agile_led_t, slist);
+        if (agile_led_get_state(led, tick, &state) != RT_EOK)
+            continue;
+        num++;
+        if ((led->pin / 32) >= (uint32_t)bitmap_size)
+            continue;
+        if (state.level)
+            bitmap[led->pin / 32] |= (1UL << (led->pin % 32));
+    }
+    rt_exit_critical();
+
+    return num;
 }
 
 /**
  * @brief   处理所有 Agile Led 对象
- * @note    如果使能 PKG_AGILE_LED_USING_THREAD_AUTO_INIT, 这个函数将被自动初始化线程 5ms 周期调用。
- *          用户调用需要创建一个线程并将这个函数放入 while (1) {} 中。
+ * @note    如果使能 PKG_AGILE_LED_USING_THREAD_AUTO_INIT, 这个函数将被自动初始化线程 自动调用。
+ *          用户调用需要创建一个线程并将这个函数放入 while (1) {} 中，
+ *          可使用 agile_led_get_wakeup_timeout 获取下次调用前的等待时间。
  */
 void agile_led_process(void)
 {
     rt_slist_t *node;
 
     rt_mutex_take(&_mtx, RT_WAITING_FOREVER);
+#ifdef PKG_AGILE_LED_USING_ENERGY
+    agile_led_duty_update();
+#endif
     rt_slist_for_each(node, &_slist_head)
     {
         agile_led_t *led = rt_slist_entry(node, agile_led_t, slist);
-        if (led->loop_cnt == 0) {
-            agile_led_stop(led);
-            if (led->compelete) {
-                led->compelete(led);
-            }
-
+        if (agile_led_handle(led) == 2)
             node = &_slist_head;
+    }
+    rt_mutex_release(&_mtx);
+}
+
+/**
+ * @brief   分批处理 Agile Led 对象
+ * @note    每次调用最多处理 max_num 个到期对象或运行 max_us 微秒，未处理完的下次调用从中断处继续。
+ *          对象按链表顺序轮流处理，每个到期对象最多等待 (运行对象数目 / max_num) 次调用。
+ *          时间预算需要先使用 agile_led_set_clock_us 设置微秒时钟，否则忽略。
+ * @param   max_num 最多处理的到期对象数目 (0 为不限制)
+ * @param   max_us 最长运行时间 (微秒，0 为不限制)
+ * @return  本次处理的到期对象数目
+ */
+int agile_led_process_budget(uint32_t max_num, uint32_t max_us)
+{
+    uint32_t clock_start = 0;
+    int num = 0;
+
+    rt_mutex_take(&_mtx, RT_WAITING_FOREVER);
+    if (_clock_us)
+        clock_start = _clock_us();
+#ifdef PKG_AGILE_LED_USING_ENERGY
+    agile_led_duty_update();
+#endif
+
+    uint32_t total = rt_slist_len(&_slist_head);
+    for (uint32_t i = 0; i < total; i++) {
+        rt_slist_t *node = _cursor ? _cursor : rt_slist_first(&_slist_head);
+        if (node == RT_NULL)
+            break;
+        _cursor = rt_slist_next(node);
+
+        agile_led_t *led = rt_slist_entry(node, agile_led_t, slist);
+        if (agile_led_handle(led) == 0)
             continue;
+
+        num++;
+        if (max_num && ((uint32_t)num >= max_num))
+            break;
+        if (max_us && _clock_us && ((_clock_us() - clock_start) >= max_us))
+            break;
+    }
+    rt_mutex_release(&_mtx);
+
+    return num;
+}
+
+/**
+ * @brief   设置分批处理使用的微秒时钟
+ * @param   clock_us 微秒时钟函数，返回值允许溢出回绕 (RT_NULL 为取消)
+ * @return  RT_EOK:成功
+ */
+int agile_led_set_clock_us(uint32_t (*clock_us)(void))
+{
+    rt_mutex_take(&_mtx, RT_WAITING_FOREVER);
+    _clock_us = clock_us;
+    rt_mutex_release(&_mtx);
+
+    return RT_EOK;
+}
+
+/**
+ * @brief   设置滞后上报
+ * @note    对象处理时刻晚于超时时间超过 (宽限时间 + 阈值) 时调用回调函数
+ * @param   threshold 滞后阈值 (tick)
+ * @param   late 滞后上报回调函数 (RT_NULL 为关闭滞后上报，可使用 agile_led_default_late_callback 打印警告)
+ * @return  RT_EOK:成功
+ */
+int agile_led_set_late_callback(rt_tick_t threshold, void (*late)(agile_led_t *led, rt_tick_t tick_late))
+{
+    rt_mutex_take(&_mtx, RT_WAITING_FOREVER);
+    _late_threshold = threshold;
+    _late = late;
+    rt_mutex_release(&_mtx);
+
+    return RT_EOK;
+}
+
+/**
+ * @brief   Agile Led 对象默认滞后上报回调函数，打印警告
+ * @note    供 agile_led_set_late_callback 使用
+ * @param   led Agile Led 对象指针
+ * @param   tick_late 滞后时间
+ */
+void agile_led_default_late_callback(agile_led_t *led, rt_tick_t tick_late)
+{
+    RT_ASSERT(led);
+    LOG_W("led pin:%d late %d ticks.", led->pin, tick_late);
+}
+
+/**
+ * @brief   设置 Agile Led 对象超时宽限时间
+ * @note    对象超时后允许最多延迟宽限时间处理，以便与其他对象合并到同一次唤醒。
+ *          需要精确定时的对象设置为 0。
+ * @param   led Agile Led 对象指针
+ * @param   slack 宽限时间 (tick，AGILE_LED_SLACK_DEFAULT 为使用默认宽限时间)
+ * @return  RT_EOK:成功
+ */
+int agile_led_set_slack(agile_led_t *led, rt_tick_t slack)
+{
+    RT_ASSERT(led);
+    RT_ASSERT((slack == AGILE_LED_SLACK_DEFAULT) || (slack < (RT_TICK_MAX / 2)));
+
+    rt_mutex_take(&_mtx, RT_WAITING_FOREVER);
+    led->tick_slack = slack;
+    rt_mutex_release(&_mtx);
+
+    agile_led_wakeup();
+
+    return RT_EOK;
+}
+
+/**
+ * @brief   设置默认超时宽限时间
+ * @note    默认为 PKG_AGILE_LED_DEFAULT_SLACK_MS
+ * @param   slack 宽限时间 (tick)
+ * @return  RT_EOK:成功
+ */
+int agile_led_set_default_slack(rt_tick_t slack)
+{
+    RT_ASSERT(slack < (RT_TICK_MAX / 2));
+
+    rt_mutex_take(&_mtx, RT_WAITING_FOREVER);
+    _slack = slack;
+    rt_mutex_release(&_mtx);
+
+    agile_led_wakeup();
+
+    return RT_EOK;
+}
+
+/**
+ * @brief   获取下次调用 agile_led_process 前的等待时间
+ * @note    取所有运行对象 (超时时间 + 宽限时间) 的最小值，
+ *          超时时间相差在宽限时间内的对象在同一次调用中处理。
+ * @return  等待时间 (tick); RT_WAITING_FOREVER:没有运行的对象
+ */
+rt_int32_t agile_led_get_wakeup_timeout(void)
+{
+    rt_slist_t *node;
+    rt_tick_t timeout = RT_TICK_MAX;
+
+    rt_mutex_take(&_mtx, RT_WAITING_FOREVER);
+    rt_tick_t tick_now = rt_tick_get();
+    rt_slist_for_each(node, &_slist_head)
+    {
+        agile_led_t *led = rt_slist_entry(node, agile_led_t, slist);
+        rt_tick_t remain = led->tick_timeout - tick_now;
+        if ((led->loop_cnt == 0) || (remain >= (RT_TICK_MAX / 2))) {
+            timeout = 0;
+            break;
         }
-    __repeat:
-        if ((rt_tick_get() - led->tick_timeout) < (RT_TICK_MAX / 2)) {
-            if (led->arr_index < led->arr_num) {
-                if (led->light_arr[led->arr_index] == 0) {
-                    led->arr_index++;
-                    goto __repeat;
-                }
-                if (led->arr_index % 2) {
-                    agile_led_off(led);
-                } else {
-                    agile_led_on(led);
-                }
-                led->tick_timeout = rt_tick_get() + rt_tick_from_millisecond(led->light_arr[led->arr_index]);
-                led->arr_index++;
-            } else {
-                led->arr_index = 0;
-                if (led->loop_cnt > 0)
-                    led->loop_cnt--;
-            }
-        }
+        remain += agile_led_get_slack(led);
+        if (remain < timeout)
+            timeout = remain;
+    }
+    rt_mutex_release(&_mtx);
+
+    if (timeout == RT_TICK_MAX)
+        return RT_WAITING_FOREVER;
+
+    return (rt_int32_t)timeout;
+}
+
+#ifdef PKG_AGILE_LED_USING_ENERGY
+
+/**
+ * @brief   设置 Agile Led 对象亮时电流
+ * @param   led Agile Led 对象指针
+ * @param   current 亮时电流 (uA)
+ * @return  RT_EOK:成功
+ */
+int agile_led_set_current(agile_led_t *led, uint32_t current)
+{
+    RT_ASSERT(led);
+
+    rt_enter_critical();
+    /* 先结算当前亮时间，之前的部分按原电流计算 */
+    if (led->lit) {
+        agile_led_account(led, 0);
+        agile_led_account(led, 1);
+    }
+    led->current = current;
+    rt_exit_critical();
+
+    return RT_EOK;
+}
+
+/**
+ * @brief   获取 Agile Led 对象能耗统计
+ * @note    包含当前正在亮的时间
+ * @param   led Agile Led 对象指针
+ * @param   energy 存放能耗统计
+ * @return  RT_EOK:成功
+ */
+int agile_led_get_energy(agile_led_t *led, agile_led_energy_t *energy)
+{
+    RT_ASSERT(led);
+    RT_ASSERT(energy);
+
+    rt_tick_t tick = rt_tick_get();
+
+    rt_enter_critical();
+    energy->on_tick = led->on_tick;
+    energy->charge = led->charge;
+    if (led->lit) {
+        energy->on_tick += tick - led->tick_lit;
+        energy->charge += (uint64_t)(tick - led->tick_lit) * led->current;
+    }
+    energy->total_tick = tick - led->tick_account;
+    energy->charge /= RT_TICK_PER_SECOND;
+    rt_exit_critical();
+
+    energy->duty = energy->total_tick ? (uint32_t)(energy->on_tick * 1000 / energy->total_tick) : 0;
+
+    return RT_EOK;
+}
+
+/**
+ * @brief   获取全局能耗统计
+ * @note    所有对象累计，只统计到各对象最近一次灭为止
+ * @param   energy 存放能耗统计
+ * @return  RT_EOK:成功
+ */
+int agile_led_get_total_energy(agile_led_energy_t *energy)
+{
+    RT_ASSERT(energy);
+
+    rt_enter_critical();
+    energy->on_tick = _on_tick;
+    energy->total_tick = rt_tick_get() - _tick_account;
+    energy->charge = _charge / RT_TICK_PER_SECOND;
+    rt_exit_critical();
+
+    energy->duty = energy->total_tick ? (uint32_t)(energy->on_tick * 1000 / energy->total_tick) : 0;
+
+    return RT_EOK;
+}
+
+/**
+ * @brief   清零能耗统计
+ * @param   led Agile Led 对象指针 (RT_NULL 为清零全局统计)
+ * @return  RT_EOK:成功
+ */
+int agile_led_reset_energy(agile_led_t *led)
+{
+    rt_tick_t tick = rt_tick_get();
+
+    rt_enter_critical();
+    if (led) {
+        led->on_tick = 0;
+        led->charge = 0;
+        led->tick_lit = tick;
+        led->tick_account = tick;
+    } else {
+        _on_tick = 0;
+        _charge = 0;
+        _tick_account = tick;
+        _window_on_tick = 0;
+        _tick_window = tick;
+    }
+    rt_exit_critical();
+
+    return RT_EOK;
+}
+
+/**
+ * @brief   设置全局占空比上限
+ * @note    每个统计窗口 (PKG_AGILE_LED_ENERGY_WINDOW_MS) 计算所有对象的平均同时亮数目，
+ *          超过上限时按比例拉伸闪烁模式中的灭时间，最多拉伸 PKG_AGILE_LED_ENERGY_STRETCH_MAX。
+ *          拉伸后 agile_led_get_state 在被拉伸的灭时间内结果不准确。
+ * @param   duty_cap 上限 (‰，如 1500 表示平均同时亮 1.5 个对象; 0 为不限制)
+ * @return  RT_EOK:成功
+ */
+int agile_led_set_duty_cap(uint32_t duty_cap)
+{
+    rt_mutex_take(&_mtx, RT_WAITING_FOREVER);
+    _duty_cap = duty_cap;
+    if (_duty_cap == 0)
+        _stretch = 1000;
+    rt_mutex_release(&_mtx);
+
+    return RT_EOK;
+}
+
+#endif /* PKG_AGILE_LED_USING_ENERGY */
+
+#ifdef PKG_AGILE_LED_USING_TRACE
+
+/**
+ * @brief   读取 Agile Led 跟踪事件
+ * @note    不获取互斥锁。seq 早于缓冲区中最早的事件时从最早的事件开始读取，
+ *          读取期间被覆盖的事件丢弃。
+ * @param   seq 起始序号，读取后更新为下一个序号 (首次读取传入 0)
+ * @param   buf 存放事件的缓冲区
+ * @param   size 缓冲区事件数目
+ * @return  读取的事件数目
+ */
+int agile_led_trace_read(uint32_t *seq, agile_led_trace_event_t *buf, int size)
+{
+    RT_ASSERT(seq);
+    RT_ASSERT(buf);
+
+    /* 序号为 head 的事件可能正在写入，与序号 head - SIZE 的事件共用同一位置 */
+    uint32_t head = _trace_head;
+    uint32_t start = *seq;
+    if ((head - start) >= PKG_AGILE_LED_TRACE_SIZE)
+        start = (head >= PKG_AGILE_LED_TRACE_SIZE) ? (head - PKG_AGILE_LED_TRACE_SIZE + 1) : 0;
+
+    AGILE_LED_TRACE_BARRIER();
+    uint32_t num = head - start;
+    if (num > (uint32_t)size)
+        num = size;
+    for (uint32_t i = 0; i < num; i++)
+        buf[i] = _trace_buf[(start + i) & (PKG_AGILE_LED_TRACE_SIZE - 1)];
+    AGILE_LED_TRACE_BARRIER();
+
+    uint32_t drop = 0;
+    head = _trace_head;
+    while ((drop < num) && ((head - (start + drop)) >= PKG_AGILE_LED_TRACE_SIZE))
+        drop++;
+    if (drop) {
+        num -= drop;
+        rt_memmove(buf, buf + drop, num * sizeof(agile_led_trace_event_t));
     }
+
+    *seq = start + drop + num;
+
+    return num;
+}
+
+/**
+ * @brief   清空 Agile Led 跟踪事件
+ */
+void agile_led_trace_clear(void)
+{
+    rt_mutex_take(&_mtx, RT_WAITING_FOREVER);
+    _trace_head = 0;
     rt_mutex_release(&_mtx);
 }
 
+#endif /* PKG_AGILE_LED_USING_TRACE */
+
 /**
  * @brief   Agile Led 环境初始化
  * @note    使用其他 API 之前该函数必须被调用。
@@ -553,6 +1610,14 @@ void agile_led_env_init(void)
         return;
 
     rt_mutex_init(&_mtx, "led_mtx", RT_IPC_FLAG_FIFO);
+#ifdef PKG_AGILE_LED_USING_THREAD_AUTO_INIT
+    rt_event_init(&_event, "led_evt", RT_IPC_FLAG_FIFO);
+#endif
+    _slack = rt_tick_from_millisecond(PKG_AGILE_LED_DEFAULT_SLACK_MS);
+#ifdef PKG_AGILE_LED_USING_ENERGY
+    _tick_account = rt_tick_get();
+    _tick_window = _tick_account;
+#endif
 
     _is_init = 1;
 }
@@ -561,6 +1626,106 @@ void agile_led_env_init(void)
  * @}
  */
 
+#if defined(PKG_AGILE_LED_USING_TRACE) && defined(RT_USING_FINSH)
+
+/** @defgroup AGILE_LED_Trace_Shell Agile Led Trace Shell
+ * @{
+ */
+
+/**
+ * @brief   导出 Agile Led 跟踪事件
+ @verbatim
+    agile_led_trace         以十六进制导出事件原始数据，每行一个事件 (8 字节，小端)
+    agile_led_trace clear   清空事件
+
+    使用 tools/agile_led_trace.py 解析
+
+ @endverbatim
+ * @param   argc 参数数目
+ * @param   argv 参数列表
+ */
+static void agile_led_trace(int argc, char **argv)
+{
+    agile_led_trace_event_t events[8];
+    uint32_t seq = 0;
+    int num;
+
+    if ((argc > 1) && (rt_strcmp(argv[1], "clear") == 0)) {
+        agile_led_trace_clear();
+        return;
+    }
+
+    rt_kprintf("agile_led trace begin\r\n");
+    while ((num = agile_led_trace_read(&seq, events, 8)) > 0) {
+        for (int i = 0; i < num; i++) {
+            const uint8_t *data = (const uint8_t *)&events[i];
+            for (uint32_t j = 0; j < sizeof(agile_led_trace_event_t); j++)
+                rt_kprintf("%02x", data[j]);
+            rt_kprintf("\r\n");
+        }
+    }
+    rt_kprintf("agile_led trace end\r\n");
+}
+MSH_CMD_EXPORT(agile_led_trace, dump agile led trace events);
+
+/**
+ * @}
+ */
+
+#endif /* defined(PKG_AGILE_LED_USING_TRACE) && defined(RT_USING_FINSH) */
+
+#if defined(PKG_AGILE_LED_USING_ENERGY) && defined(RT_USING_FINSH)
+
+/** @defgroup AGILE_LED_Energy_Shell Agile Led Energy Shell
+ * @{
+ */
+
+/**
+ * @brief   打印 Agile Led 能耗统计
+ @verbatim
+    agile_led_energy        打印全局及运行中对象的占空比和估算电荷量
+    agile_led_energy reset  清零全局统计
+
+ @endverbatim
+ * @param   argc 参数数目
+ * @param   argv 参数列表
+ */
+static void agile_led_energy(int argc, char **argv)
+{
+    agile_led_energy_t energy;
+    rt_slist_t *node;
+
+    if ((argc > 1) && (rt_strcmp(argv[1], "reset") == 0)) {
+        agile_led_reset_energy(RT_NULL);
+        return;
+    }
+
+    agile_led_get_total_energy(&energy);
+    /* 全局 duty 为平均同时亮的对象数目 × 1000，可能超过 100% */
+    rt_kprintf("total: on %u ms / %u ms, avg lit %u.%03u, charge %u uAh\r\n",
+               (uint32_t)(energy.on_tick * 1000 / RT_TICK_PER_SECOND),
+               (uint32_t)((uint64_t)energy.total_tick * 1000 / RT_TICK_PER_SECOND),
+               energy.duty / 1000, energy.duty % 1000, (uint32_t)(energy.charge / 3600));
+
+    rt_mutex_take(&_mtx, RT_WAITING_FOREVER);
+    rt_slist_for_each(node, &_slist_head)
+    {
+        agile_led_t *led = rt_slist_entry(node, agile_led_t, slist);
+        agile_led_get_energy(led, &energy);
+        rt_kprintf("pin %-4d: on %u ms, duty %u.%u%%, current %u uA, charge %u uAh\r\n", led->pin,
+                   (uint32_t)(energy.on_tick * 1000 / RT_TICK_PER_SECOND),
+                   energy.duty / 10, energy.duty % 10, led->current, (uint32_t)(energy.charge / 3600));
+    }
+    rt_mutex_release(&_mtx);
+}
+MSH_CMD_EXPORT(agile_led_energy, show agile led energy statistics);
+
+/**
+ * @}
+ */
+
+#endif /* defined(PKG_AGILE_LED_USING_ENERGY) && defined(RT_USING_FINSH) */
+
 #ifdef PKG_AGILE_LED_USING_THREAD_AUTO_INIT
 
 /** @addtogroup AGILE_LED_Thread_Auto_Init
@@ -577,9 +1742,11 @@ void agile_led_env_init(void)
  */
 static void agile_led_auto_thread_entry(void *parameter)
 {
+    rt_uint32_t recved;
+
     while (1) {
         agile_led_process();
-        rt_thread_mdelay(5);
+        rt_event_recv(&_event, 0x01, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, agile_led_get_wakeup_timeout(), &recved);
     }
 }
 
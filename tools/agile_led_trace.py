@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Agile Led 跟踪事件解析及回放校验工具
+
+使用:
+    解析 msh `agile_led_trace` 命令输出:
+        python3 agile_led_trace.py decode trace.log
+
+    按闪烁模式在虚拟时钟上回放，校验记录的事件时间线:
+        python3 agile_led_trace.py check trace.log --pin 18 --mode "100,200" --loop 3 --tolerance 5
+
+    --tick-per-second 需与 RT_TICK_PER_SECOND 一致，--tolerance 为允许的滞后时间 (tick)，
+    一般取超时宽限时间。校验失败时返回 1。
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+EVENT_FORMAT = '<IHBB'
+EVENT_SIZE = struct.calcsize(EVENT_FORMAT)
+
+TRACE_START = 0x01
+TRACE_STOP = 0x02
+TRACE_COMPLETE = 0x03
+TRACE_ON = 0x04
+TRACE_OFF = 0x05
+
+EVENT_NAMES = {
+    TRACE_START: 'start',
+    TRACE_STOP: 'stop',
+    TRACE_COMPLETE: 'complete',
+    TRACE_ON: 'on',
+    TRACE_OFF: 'off',
+}
+
+LINE_PATTERN = re.compile(r'^\s*([0-9a-fA-F]{%d})\s*$' % (EVENT_SIZE * 2))
+FIELD_PATTERN = re.compile(r'^[ \t]*([0-9]+)[ \t]*$')
+
+RT_TICK_MAX = 0xFFFFFFFF
+
+
+def load_events(path):
+    """读取 msh 输出，忽略非事件行"""
+    events = []
+    with open(path, 'r', errors='ignore') as f:
+        for line in f:
+            match = LINE_PATTERN.match(line)
+            if not match:
+                continue
+            tick, pin, type_, late = struct.unpack(EVENT_FORMAT, bytes.fromhex(match.group(1)))
+            events.append({'tick': tick, 'pin': pin, 'type': type_, 'late': late})
+    return events
+
+
+def tick_from_millisecond(ms, tick_per_second):
+    """与 rt_tick_from_millisecond 一致的换算"""
+    tick = tick_per_second * (ms // 1000)
+    tick += (tick_per_second * (ms % 1000) + 999) // 1000
+    return tick
+
+
+def light_max(tick_per_second):
+    """与 AGILE_LED_LIGHT_MAX 一致，单个元素转换为 tick 不超过 RT_TICK_MAX / 2"""
+    return ((RT_TICK_MAX // 2) // tick_per_second) * 1000
+
+
+def parse_light_mode(light_mode, tick_per_second):
+    """与 agile_led_parse_light_mode 规则一致，并拒绝引擎不会运行的模式 (周期为 0 或溢出)"""
+    fields = light_mode.split(',')
+    # 允许末尾一个逗号
+    if len(fields) > 1 and fields[-1] == '':
+        fields.pop()
+
+    light_arr = []
+    for field in fields:
+        match = FIELD_PATTERN.match(field)
+        if not match:
+            raise ValueError('invalid field "%s"' % field)
+        value = int(match.group(1))
+        if value > light_max(tick_per_second):
+            raise ValueError('value %d exceeds %d' % (value, light_max(tick_per_second)))
+        light_arr.append(value)
+
+    period = sum(tick_from_millisecond(ms, tick_per_second) for ms in light_arr)
+    if period == 0 or period > RT_TICK_MAX // 2:
+        raise ValueError('period is zero or overflows')
+    return light_arr
+
+
+def expected_timeline(start, light_arr, loop_cnt, tick_per_second, max_tick):
+    """虚拟时钟回放闪烁模式，生成理想事件时间线"""
+    timeline = []
+    ticks = [tick_from_millisecond(ms, tick_per_second) for ms in light_arr]
+    period = sum(ticks)
+    if period == 0:
+        return timeline
+
+    tick = start
+    cycle = 0
+    while (loop_cnt < 0 or cycle < loop_cnt) and tick <= max_tick:
+        for index, light in enumerate(ticks):
+            if light == 0:
+                continue
+            timeline.append((tick, TRACE_OFF if index % 2 else TRACE_ON))
+            tick += light
+        cycle += 1
+
+    if loop_cnt >= 0 and cycle >= loop_cnt:
+        timeline.append((tick, TRACE_COMPLETE))
+    return timeline
+
+
+def check(events, pin, light_arr, loop_cnt, tick_per_second, tolerance):
+    """校验指定引脚每次启动后的事件，返回错误列表"""
+    events = [e for e in events if e['pin'] == pin]
+    errors = []
+    segments = []
+    for event in events:
+        if event['type'] == TRACE_START:
+            segments.append([event])
+        elif segments:
+            segments[-1].append(event)
+
+    for segment in segments:
+        start = segment[0]['tick']
+        actual = [e for e in segment[1:] if e['type'] in (TRACE_ON, TRACE_OFF, TRACE_COMPLETE)]
+        if not actual:
+            continue
+        timeline = expected_timeline(start, light_arr, loop_cnt, tick_per_second, actual[-1]['tick'])
+        for event, expect in zip(actual, timeline):
+            delta = event['tick'] - expect[0]
+            if event['type'] != expect[1]:
+                errors.append('tick %d: expect %s, got %s' % (event['tick'], EVENT_NAMES[expect[1]],
+                                                              EVENT_NAMES.get(event['type'], event['type'])))
+                break
+            if delta < 0 or delta > tolerance:
+                errors.append('tick %d: %s expected at %d (delta %d)' % (event['tick'], EVENT_NAMES[event['type']],
+                                                                         expect[0], delta))
+        if len(actual) > len(timeline):
+            errors.append('start at tick %d: %d unexpected events' % (start, len(actual) - len(timeline)))
+    return errors
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Agile Led trace decoder')
+    sub = parser.add_subparsers(dest='cmd')
+    sub.required = True
+
+    decode_parser = sub.add_parser('decode', help='decode trace dump')
+    decode_parser.add_argument('file')
+
+    check_parser = sub.add_parser('check', help='replay light mode and check trace')
+    check_parser.add_argument('file')
+    check_parser.add_argument('--pin', type=int, required=True)
+    check_parser.add_argument('--mode', required=True, help='light mode, e.g. "100,200"')
+    check_parser.add_argument('--loop', type=int, default=-1)
+    check_parser.add_argument('--tick-per-second', type=int, default=1000)
+    check_parser.add_argument('--tolerance', type=int, default=5)
+
+    args = parser.parse_args()
+    events = load_events(args.file)
+
+    if args.cmd == 'decode':
+        for event in events:
+            print('%10d  pin %-5d %-9s late %d' % (event['tick'], event['pin'],
+                                                  EVENT_NAMES.get(event['type'], '0x%02x' % event['type']),
+                                                  event['late']))
+        return 0
+
+    try:
+        light_arr = parse_light_mode(args.mode, args.tick_per_second)
+    except ValueError as e:
+        parser.error('--mode "%s": %s' % (args.mode, e))
+    errors = check(events, args.pin, light_arr, args.loop, args.tick_per_second, args.tolerance)
+    for error in errors:
+        print(error)
+    print('%s: %d errors' % ('FAIL' if errors else 'PASS', len(errors)))
+    return 1 if errors else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,49 @@
+/**
+ * @file    bench_light_mode.c
+ * @brief   agile_led_parse_light_mode 吞吐量测试
+ *
+ @verbatim
+    gcc -O2 -Itools/host -Iinc tools/bench_light_mode.c src/agile_led.c -o bench_light_mode
+    ./bench_light_mode [元素数目] [次数]
+
+    每次先只计数再填充，与动态对象创建时的调用方式一致
+
+ @endverbatim
+ */
+
+#include <agile_led.h>
+#include <time.h>
+
+int main(int argc, char **argv)
+{
+    int arr_num = (argc > 1) ? atoi(argv[1]) : 16;
+    int loops = (argc > 2) ? atoi(argv[2]) : 1000000;
+    char *light_mode = malloc(arr_num * 12 + 1);
+    uint32_t *light_arr = malloc(arr_num * sizeof(uint32_t));
+    size_t len = 0;
+    uint32_t check = 0;
+    struct timespec begin, end;
+
+    if ((arr_num <= 0) || (loops <= 0))
+        return 1;
+
+    for (int i = 0; i < arr_num; i++)
+        len += sprintf(light_mode + len, "%s%u", i ? "," : "", (uint32_t)(50 + i * 37) % 100000);
+
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    for (int i = 0; i < loops; i++) {
+        int num = agile_led_parse_light_mode(light_mode, RT_NULL, 0, RT_NULL);
+        agile_led_parse_light_mode(light_mode, light_arr, num, RT_NULL);
+        check += light_arr[i % num];
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (end.tv_sec - begin.tv_sec) + (end.tv_nsec - begin.tv_nsec) / 1e9;
+    printf("%d elements, %zu bytes, %d loops: %.1f ns/parse, %.1f MB/s (check %u)\n",
+           arr_num, len, loops, seconds * 1e9 / loops, (double)len * loops / seconds / 1e6, check);
+
+    free(light_arr);
+    free(light_mode);
+
+    return 0;
+}
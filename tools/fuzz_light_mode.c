@@ -0,0 +1,83 @@
+/**
+ * @file    fuzz_light_mode.c
+ * @brief   agile_led_parse_light_mode 模糊测试
+ *
+ @verbatim
+    libFuzzer:
+    clang -g -O1 -fsanitize=fuzzer,address,undefined -Itools/host -Iinc \
+        tools/fuzz_light_mode.c src/agile_led.c -o fuzz_light_mode
+    ./fuzz_light_mode
+
+    AFL (或直接回放用例):
+    afl-gcc -DAGILE_LED_FUZZ_MAIN -Itools/host -Iinc \
+        tools/fuzz_light_mode.c src/agile_led.c -o fuzz_light_mode
+    afl-fuzz -i corpus -o findings ./fuzz_light_mode
+
+    校验: 只计数与填充结果一致、缓冲区不足时返回 -RT_EFULL、
+    错误位置在字符串范围内、数值不超过 AGILE_LED_LIGHT_MAX
+
+ @endverbatim
+ */
+
+#include <agile_led.h>
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    char *light_mode = malloc(size + 1);
+    uint32_t *light_arr = malloc((size / 2 + 1) * sizeof(uint32_t));
+    int err_pos = -1;
+    int fill_pos = -1;
+
+    memcpy(light_mode, data, size);
+    light_mode[size] = '\0';
+    size_t len = strlen(light_mode);
+
+    int num = agile_led_parse_light_mode(light_mode, RT_NULL, 0, &err_pos);
+    int fill = agile_led_parse_light_mode(light_mode, light_arr, size / 2 + 1, &fill_pos);
+
+    if (num > 0) {
+        /* 每个元素至少 1 个数字和 1 个逗号 (最后一个除外) */
+        if ((size_t)num > len / 2 + 1 || fill != num)
+            abort();
+        for (int i = 0; i < num; i++) {
+            if (light_arr[i] > AGILE_LED_LIGHT_MAX)
+                abort();
+        }
+        if (agile_led_parse_light_mode(light_mode, light_arr, num - 1, RT_NULL) != -RT_EFULL)
+            abort();
+    } else {
+        if ((num != -RT_EINVAL) || (fill != num) || (fill_pos != err_pos))
+            abort();
+        if ((err_pos < 0) || ((size_t)err_pos > len))
+            abort();
+    }
+
+    free(light_arr);
+    free(light_mode);
+
+    return 0;
+}
+
+#ifdef AGILE_LED_FUZZ_MAIN
+int main(int argc, char **argv)
+{
+    static uint8_t buf[65536];
+    size_t size;
+
+    if (argc < 2) {
+        size = fread(buf, 1, sizeof(buf), stdin);
+        return LLVMFuzzerTestOneInput(buf, size);
+    }
+
+    for (int i = 1; i < argc; i++) {
+        FILE *fp = fopen(argv[i], "rb");
+        if (fp == RT_NULL)
+            continue;
+        size = fread(buf, 1, sizeof(buf), fp);
+        fclose(fp);
+        LLVMFuzzerTestOneInput(buf, size);
+    }
+
+    return 0;
+}
+#endif
@@ -0,0 +1,20 @@
+/**
+ * @file    rtdbg.h
+ * @brief   主机工具使用的 RT-Thread 日志适配头文件，丢弃所有日志
+ */
+
+#ifndef __AGILE_LED_HOST_RTDBG_H
+#define __AGILE_LED_HOST_RTDBG_H
+
+/* 保留参数求值，避免未使用变量告警，同时校验格式字符串 */
+static inline void __attribute__((format(printf, 1, 2))) agile_led_host_log(const char *fmt, ...)
+{
+    (void)fmt;
+}
+
+#define LOG_D(...) agile_led_host_log(__VA_ARGS__)
+#define LOG_I(...) agile_led_host_log(__VA_ARGS__)
+#define LOG_W(...) agile_led_host_log(__VA_ARGS__)
+#define LOG_E(...) agile_led_host_log(__VA_ARGS__)
+
+#endif /* __AGILE_LED_HOST_RTDBG_H */
@@ -0,0 +1,29 @@
+/**
+ * @file    rtdevice.h
+ * @brief   主机工具使用的 RT-Thread 引脚适配头文件
+ */
+
+#ifndef __AGILE_LED_HOST_RTDEVICE_H
+#define __AGILE_LED_HOST_RTDEVICE_H
+
+#define PIN_LOW         0x00
+#define PIN_HIGH        0x01
+#define PIN_MODE_OUTPUT 0x00
+
+static inline void rt_pin_mode(rt_base_t pin, rt_base_t mode)
+{
+    (void)pin, (void)mode;
+}
+
+static inline void rt_pin_write(rt_base_t pin, rt_base_t value)
+{
+    (void)pin, (void)value;
+}
+
+static inline int rt_pin_read(rt_base_t pin)
+{
+    (void)pin;
+    return PIN_LOW;
+}
+
+#endif /* __AGILE_LED_HOST_RTDEVICE_H */
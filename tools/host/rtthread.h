@@ -0,0 +1,154 @@
+/**
+ * @file    rtthread.h
+ * @brief   主机工具使用的 RT-Thread 最小适配头文件
+ * @note    仅用于在 Linux 上编译 src/agile_led.c 运行 tools 下的模糊测试和性能测试，
+ *          单线程，不提供真实的互斥锁、线程和 tick。
+ */
+
+#ifndef __AGILE_LED_HOST_RTTHREAD_H
+#define __AGILE_LED_HOST_RTTHREAD_H
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef int8_t rt_int8_t;
+typedef int32_t rt_int32_t;
+typedef uint8_t rt_uint8_t;
+typedef uint32_t rt_uint32_t;
+typedef long rt_base_t;
+typedef int rt_err_t;
+typedef uint32_t rt_tick_t;
+
+#define RT_NULL                0
+#define RT_EOK                 0
+#define RT_ERROR               1
+#define RT_EFULL               3
+#define RT_ENOMEM              5
+#define RT_EINVAL              10
+#define RT_TICK_MAX            0xFFFFFFFFUL
+#define RT_TICK_PER_SECOND     1000
+#define RT_WAITING_FOREVER     -1
+#define RT_THREAD_PRIORITY_MAX 32
+#define RT_IPC_FLAG_FIFO       0x00
+#define RT_EVENT_FLAG_OR       0x02
+#define RT_EVENT_FLAG_CLEAR    0x04
+#define RT_ALIGN_SIZE          4
+#define RT_USING_HEAP
+
+#define ALIGN(n)           __attribute__((aligned(n)))
+#define RT_ASSERT(EX)      assert(EX)
+#define INIT_APP_EXPORT(fn)
+
+#define rt_malloc          malloc
+#define rt_free            free
+#define rt_memset          memset
+#define rt_memmove         memmove
+#define rt_strcmp          strcmp
+#define rt_kprintf         printf
+#define rt_enter_critical()
+#define rt_exit_critical()
+
+typedef struct rt_slist_node {
+    struct rt_slist_node *next;
+} rt_slist_t;
+
+#define RT_SLIST_OBJECT_INIT(object) { RT_NULL }
+
+#define rt_slist_entry(node, type, member) ((type *)((char *)(node) - (unsigned long)(&((type *)0)->member)))
+#define rt_slist_for_each(pos, head)       for (pos = (head)->next; pos != RT_NULL; pos = pos->next)
+
+static inline void rt_slist_init(rt_slist_t *l)
+{
+    l->next = RT_NULL;
+}
+
+static inline void rt_slist_append(rt_slist_t *l, rt_slist_t *n)
+{
+    while (l->next)
+        l = l->next;
+    l->next = n;
+    n->next = RT_NULL;
+}
+
+static inline rt_slist_t *rt_slist_remove(rt_slist_t *l, rt_slist_t *n)
+{
+    rt_slist_t *node = l;
+    while (node->next && (node->next != n))
+        node = node->next;
+    if (node->next)
+        node->next = node->next->next;
+    return l;
+}
+
+static inline unsigned int rt_slist_len(const rt_slist_t *l)
+{
+    unsigned int len = 0;
+    for (l = l->next; l; l = l->next)
+        len++;
+    return len;
+}
+
+static inline rt_slist_t *rt_slist_first(rt_slist_t *l)
+{
+    return l->next;
+}
+
+static inline rt_slist_t *rt_slist_next(rt_slist_t *n)
+{
+    return n->next;
+}
+
+struct rt_mutex {
+    int dummy;
+};
+
+struct rt_event {
+    int dummy;
+};
+
+static inline rt_err_t rt_mutex_init(struct rt_mutex *mutex, const char *name, rt_uint8_t flag)
+{
+    (void)mutex, (void)name, (void)flag;
+    return RT_EOK;
+}
+
+static inline rt_err_t rt_mutex_take(struct rt_mutex *mutex, rt_int32_t time)
+{
+    (void)mutex, (void)time;
+    return RT_EOK;
+}
+
+static inline rt_err_t rt_mutex_release(struct rt_mutex *mutex)
+{
+    (void)mutex;
+    return RT_EOK;
+}
+
+static inline rt_err_t rt_event_init(struct rt_event *event, const char *name, rt_uint8_t flag)
+{
+    (void)event, (void)name, (void)flag;
+    return RT_EOK;
+}
+
+static inline rt_err_t rt_event_send(struct rt_event *event, rt_uint32_t set)
+{
+    (void)event, (void)set;
+    return RT_EOK;
+}
+
+static inline rt_tick_t rt_tick_get(void)
+{
+    return 0;
+}
+
+static inline rt_tick_t rt_tick_from_millisecond(rt_int32_t ms)
+{
+    if (ms < 0)
+        return (rt_tick_t)RT_WAITING_FOREVER;
+    return RT_TICK_PER_SECOND * (ms / 1000) + (RT_TICK_PER_SECOND * (ms % 1000) + 999) / 1000;
+}
+
+#endif /* __AGILE_LED_HOST_RTTHREAD_H */